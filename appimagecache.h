@@ -0,0 +1,343 @@
+#ifndef APPIMAGECACHE_H
+#define APPIMAGECACHE_H
+
+#include <QString>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QElapsedTimer>
+#include <QCryptographicHash>
+#include <QtEndian>
+#include <QDebug>
+#include <atomic>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// Optional launch mode that runs AppImages from a one-time extraction instead of a FUSE mount.
+// Each image gets CacheLocation/appimages/v<layout>/<name>-<path hash>/ holding one directory per
+// extracted content hash and a "current" symlink that is swapped atomically to a new extraction, so
+// apps still running from an older one keep their files. Each extraction is stamped with the image's
+// size, mtime and SHA-256; a size or mtime change re-hashes and re-extracts only if the content changed.
+// A sweep removes generations nothing runs from any more and images that no longer exist.
+class AppImageCache {
+public:
+    AppImageCache() {
+        base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/appimages";
+        root = base + "/v" + QString::number(layoutVersion);
+        pool.setMaxThreadCount(2);
+        pool.start([this]() { sweep(); });
+    }
+
+    // Abandons queued and running extractions so closing the launcher is not held up
+    ~AppImageCache() {
+        stopping = true;
+        pool.clear();
+        pool.waitForDone();
+    }
+
+    static bool isAppImage(const QString &path) {
+        return path.endsWith(".AppImage", Qt::CaseInsensitive);
+    }
+
+    // AppRun of an up-to-date extraction, or empty; only stats the image. The path names the
+    // generation itself rather than the symlink, so a later swap does not move files under the app.
+    QString cachedAppRun(const QString &appImage) const {
+        QString dir = QFileInfo(imageDir(appImage) + "/current").canonicalFilePath();
+        if (dir.isEmpty()) {
+            return QString();
+        }
+        Stamp stamp = readStamp(dir);
+        QFileInfo info(appImage);
+        if (stamp.valid && stamp.size == info.size() && stamp.mtime == info.lastModified().toMSecsSinceEpoch()
+            && QFileInfo(dir + "/AppRun").isExecutable()) {
+            return dir + "/AppRun";
+        }
+        return QString();
+    }
+
+    // Extracts in the background; two images at a time, each with a multi-threaded unsquashfs
+    void prepare(const QString &appImage) {
+        {
+            QMutexLocker locker(&mutex);
+            if (pending.contains(appImage)) return;
+            pending.insert(appImage);
+        }
+        QString dir = imageDir(appImage);
+        pool.start([this, appImage, dir]() {
+            if (!extract(appImage, dir)) {
+                qDebug() << "AppImage extraction failed:" << appImage;
+            }
+            {
+                QMutexLocker locker(&mutex);
+                pending.remove(appImage);
+            }
+            sweep();
+        });
+    }
+
+    // Synchronous extraction, used by prepare() and the benchmark
+    bool extractNow(const QString &appImage) {
+        return extract(appImage, imageDir(appImage));
+    }
+
+    // Environment AppRun expects when started outside the AppImage runtime
+    static QProcessEnvironment environment(const QString &appImage, const QString &appRun) {
+        QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+        environment.insert("APPIMAGE", appImage);
+        environment.insert("APPDIR", QFileInfo(appRun).absolutePath());
+        environment.insert("ARGV0", appImage);
+        return environment;
+    }
+
+private:
+    static constexpr int layoutVersion = 2;
+
+    struct Stamp {
+        bool valid = false;
+        qint64 size = 0;
+        qint64 mtime = 0;
+        QByteArray sha256;
+    };
+
+    QString imageDir(const QString &appImage) const {
+        QByteArray key = QCryptographicHash::hash(QFileInfo(appImage).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex().left(16);
+        return root + "/" + QFileInfo(appImage).completeBaseName() + "-" + QString::fromLatin1(key);
+    }
+
+    // Whether any process runs a binary from, maps a file from, or sits in a directory below path
+    static bool inUse(const QString &path) {
+        QString prefix = path + "/";
+        QByteArray mapsPrefix = QFile::encodeName(prefix);
+        const QStringList pids = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QString &pid : pids) {
+            if (!pid[0].isDigit()) continue;
+            QString proc = "/proc/" + pid;
+            if (QFile::symLinkTarget(proc + "/exe").startsWith(prefix) || (QFile::symLinkTarget(proc + "/cwd") + "/").startsWith(prefix)) {
+                return true;
+            }
+            QFile maps(proc + "/maps");
+            if (maps.open(QIODevice::ReadOnly) && maps.readAll().contains(mapsPrefix)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Drops old layouts, images that were deleted or moved, and generations that are neither current
+    // nor in use. Images with an extraction in flight are left alone.
+    void sweep() {
+        for (const QFileInfo &layout : QDir(base).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks)) {
+            if (layout.absoluteFilePath() != root && !inUse(layout.absoluteFilePath())) {
+                QDir(layout.absoluteFilePath()).removeRecursively();
+            }
+        }
+        QSet<QString> busy;
+        {
+            QMutexLocker locker(&mutex);
+            for (const QString &appImage : std::as_const(pending)) busy.insert(imageDir(appImage));
+        }
+        for (const QFileInfo &image : QDir(root).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks)) {
+            QString dir = image.absoluteFilePath();
+            if (busy.contains(dir) || stopping) {
+                continue;
+            }
+            QFile source(dir + "/.apex-source");
+            QString appImage = source.open(QIODevice::ReadOnly) ? QString::fromUtf8(source.readAll().trimmed()) : QString();
+            if (!QFileInfo(appImage).isFile()) {
+                if (!inUse(dir)) QDir(dir).removeRecursively();
+                continue;
+            }
+            QString current = QFileInfo(dir + "/current").symLinkTarget();
+            // NoSymLinks: "current" itself must not be followed and emptied
+            for (const QFileInfo &generation : QDir(dir).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks)) {
+                if (generation.absoluteFilePath() != current && !inUse(generation.absoluteFilePath())) {
+                    QDir(generation.absoluteFilePath()).removeRecursively();
+                }
+            }
+        }
+    }
+
+    static Stamp readStamp(const QString &dir) {
+        Stamp stamp;
+        QFile file(dir + "/.apex-extract");
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            return stamp;
+        }
+        QList<QByteArray> fields = file.readAll().trimmed().split('\t');
+        if (fields.size() == 3) {
+            stamp.size = fields[0].toLongLong();
+            stamp.mtime = fields[1].toLongLong();
+            stamp.sha256 = fields[2];
+            stamp.valid = true;
+        }
+        return stamp;
+    }
+
+    static bool writeStamp(const QString &dir, const Stamp &stamp) {
+        QSaveFile file(dir + "/.apex-extract");
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            return false;
+        }
+        file.write(QByteArray::number(stamp.size) + '\t' + QByteArray::number(stamp.mtime) + '\t' + stamp.sha256 + '\n');
+        return file.commit();
+    }
+
+    static QByteArray sha256(const QString &path) {
+        QFile file(path);
+        QCryptographicHash hash(QCryptographicHash::Sha256);
+        if (!file.open(QIODevice::ReadOnly) || !hash.addData(&file)) {
+            return QByteArray();
+        }
+        return hash.result().toHex();
+    }
+
+    // Type 2 AppImages append the squashfs right after the ELF runtime's section headers
+    static qint64 squashfsOffset(const QString &path) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return -1;
+        }
+        QByteArray header = file.read(64);
+        if (header.size() < 64 || !header.startsWith("\x7f" "ELF")) {
+            return -1;
+        }
+        const uchar *data = reinterpret_cast<const uchar *>(header.constData());
+        if (data[4] == 2) { // ELFCLASS64
+            return qint64(qFromLittleEndian<quint64>(data + 0x28)) + qint64(qFromLittleEndian<quint16>(data + 0x3A)) * qFromLittleEndian<quint16>(data + 0x3C);
+        }
+        return qint64(qFromLittleEndian<quint32>(data + 0x20)) + qint64(qFromLittleEndian<quint16>(data + 0x2E)) * qFromLittleEndian<quint16>(data + 0x30);
+    }
+
+    // The helper stays in the launcher's own session. The launcher's ProcessSupervisor
+    // only waits on processes of launched sessions, so the exit status stays with this QProcess
+    static bool run(const QString &program, const QStringList &arguments, const QString &workingDir) {
+        QProcess process;
+        process.setProgram(program);
+        process.setArguments(arguments);
+        process.setWorkingDirectory(workingDir);
+        process.setProcessChannelMode(QProcess::MergedChannels);
+        process.setChildProcessModifier([]() { setpriority(PRIO_PROCESS, 0, 10); }); // Stay out of the way
+        process.start();
+        QElapsedTimer elapsed;
+        elapsed.start();
+        while (!process.waitForFinished(200)) {
+            if (process.state() == QProcess::NotRunning || stopping || elapsed.hasExpired(10 * 60 * 1000)) {
+                process.kill();
+                process.waitForFinished(1000);
+                return false;
+            }
+        }
+        if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+            qDebug() << program << "failed:" << process.readAll().right(500);
+            return false;
+        }
+        return true;
+    }
+
+    static bool extract(const QString &appImage, const QString &imageDir) {
+        QFileInfo before(appImage);
+        if (!before.isFile()) {
+            return false;
+        }
+        Stamp stamp;
+        stamp.size = before.size();
+        stamp.mtime = before.lastModified().toMSecsSinceEpoch();
+        stamp.sha256 = sha256(appImage);
+        if (stamp.sha256.isEmpty()) {
+            return false;
+        }
+
+        // Only touched, not changed: refresh the stamp and keep the extraction
+        QString current = QFileInfo(imageDir + "/current").canonicalFilePath();
+        Stamp old = current.isEmpty() ? Stamp() : readStamp(current);
+        if (old.valid && old.sha256 == stamp.sha256 && QFileInfo(current + "/AppRun").isExecutable()) {
+            stamp.valid = true;
+            return writeStamp(current, stamp);
+        }
+
+        // A new generation next to the current one, which stays untouched for apps running from it
+        QString generation = QString::fromLatin1(stamp.sha256.left(16));
+        QString dir = imageDir + "/" + generation;
+        Stamp earlier = readStamp(dir);
+        bool reuse = earlier.valid && earlier.sha256 == stamp.sha256 && QFileInfo(dir + "/AppRun").isExecutable();
+        if (!reuse && QFileInfo::exists(dir) && inUse(dir)) {
+            return false; // A damaged copy something still runs from; try again once it has exited
+        }
+        return (reuse || extractTo(appImage, dir, stamp)) && makeCurrent(appImage, imageDir, generation, dir, stamp);
+    }
+
+    static bool extractTo(const QString &appImage, const QString &dir, const Stamp &stamp) {
+        QString partial = dir + ".partial";
+        QDir(partial).removeRecursively();
+        QDir().mkpath(partial);
+        QString extracted;
+
+        QString unsquashfs = QStandardPaths::findExecutable("unsquashfs");
+        qint64 offset = squashfsOffset(appImage);
+        if (!unsquashfs.isEmpty() && offset > 0) {
+            extracted = partial + "/root";
+            QStringList arguments{"-no-progress", "-processors", QString::number(QThread::idealThreadCount()),
+                                  "-o", QString::number(offset), "-d", extracted, appImage};
+            if (!run(unsquashfs, arguments, partial)) extracted.clear();
+        }
+        if (extracted.isEmpty()) {
+            // The runtime can extract itself without FUSE
+            extracted = partial + "/squashfs-root";
+            if (!run(appImage, {"--appimage-extract"}, partial)) extracted.clear();
+        }
+
+        // The image must not have changed underneath us, and must have produced an AppRun
+        QFileInfo after(appImage);
+        if (extracted.isEmpty() || !QFileInfo(extracted + "/AppRun").isExecutable()
+            || after.size() != stamp.size || after.lastModified().toMSecsSinceEpoch() != stamp.mtime) {
+            QDir(partial).removeRecursively();
+            return false;
+        }
+
+        QDir(dir).removeRecursively(); // Unusable leftover, checked above to be unused
+        bool moved = QDir().rename(extracted, dir);
+        QDir(partial).removeRecursively();
+        return moved;
+    }
+
+    static bool makeCurrent(const QString &appImage, const QString &imageDir, const QString &generation, const QString &dir, Stamp stamp) {
+        stamp.valid = true;
+        if (!writeStamp(dir, stamp)) {
+            return false;
+        }
+
+        // rename() over the old link makes the switch atomic for concurrent launches
+        QString link = imageDir + "/current.new";
+        QFile::remove(link);
+        if (symlink(QFile::encodeName(generation).constData(), QFile::encodeName(link).constData()) != 0
+            || ::rename(QFile::encodeName(link).constData(), QFile::encodeName(imageDir + "/current").constData()) != 0) {
+            return false;
+        }
+
+        // Remembered for the sweep, which drops extractions of images that have gone
+        QSaveFile source(imageDir + "/.apex-source");
+        if (source.open(QIODevice::WriteOnly)) {
+            source.write(QFileInfo(appImage).absoluteFilePath().toUtf8() + '\n');
+            source.commit();
+        }
+        return true;
+    }
+
+    inline static std::atomic<bool> stopping{false};
+    QString base;
+    QString root;
+    QThreadPool pool;
+    QMutex mutex;
+    QSet<QString> pending;
+};
+
+#endif // APPIMAGECACHE_H
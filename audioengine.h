@@ -0,0 +1,213 @@
+#ifndef AUDIOENGINE_H
+#define AUDIOENGINE_H
+
+#include <QObject>
+#include <QIODevice>
+#include <QAudioDecoder>
+#include <QAudioFormat>
+#include <QAudioSink>
+#include <QMediaDevices>
+#include <QAudioDevice>
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTimer>
+#include <QDebug>
+#include <algorithm>
+#include <memory>
+
+// Pull-mode mixer the sink reads from; a fixed pool of voices over preloaded 16-bit PCM
+class AudioMixerDevice : public QIODevice {
+public:
+    static constexpr int voiceCount = 8;
+
+    AudioMixerDevice(int channels, QObject *parent = nullptr) : QIODevice(parent), channels(channels) {}
+
+    bool isSequential() const override { return true; }
+
+    void trigger(int soundId, std::shared_ptr<const QByteArray> pcm, float gain) {
+        QMutexLocker locker(&mutex);
+        // Take a free voice, or steal the one that has played longest
+        int chosen = 0;
+        for (int i = 0; i < voiceCount; ++i) {
+            if (!voices[i].pcm) {
+                chosen = i;
+                break;
+            }
+            if (voices[i].position > voices[chosen].position) {
+                chosen = i;
+            }
+        }
+        voices[chosen].soundId = soundId;
+        voices[chosen].pcm = std::move(pcm);
+        voices[chosen].position = 0;
+        voices[chosen].gain = gain;
+    }
+
+    void stop(int soundId) {
+        QMutexLocker locker(&mutex);
+        for (Voice &voice : voices) {
+            if (voice.soundId == soundId) {
+                voice.pcm.reset();
+                voice.soundId = -1;
+            }
+        }
+    }
+
+    bool isIdle() {
+        QMutexLocker locker(&mutex);
+        return std::none_of(std::begin(voices), std::end(voices), [](const Voice &voice) { return bool(voice.pcm); });
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override {
+        qint64 samples = (maxSize / qint64(sizeof(qint16) * channels)) * channels;
+        qint16 *out = reinterpret_cast<qint16 *>(data);
+        std::fill(out, out + samples, qint16(0));
+
+        QMutexLocker locker(&mutex);
+        for (Voice &voice : voices) {
+            if (!voice.pcm) {
+                continue;
+            }
+            const qint16 *in = reinterpret_cast<const qint16 *>(voice.pcm->constData());
+            qint64 available = voice.pcm->size() / qint64(sizeof(qint16)) - voice.position;
+            qint64 count = std::min(samples, available);
+            for (qint64 i = 0; i < count; ++i) {
+                int mixed = out[i] + int(in[voice.position + i] * voice.gain);
+                out[i] = qint16(std::clamp(mixed, -32768, 32767));
+            }
+            voice.position += count;
+            if (voice.position * qint64(sizeof(qint16)) >= voice.pcm->size()) {
+                voice.pcm.reset();
+                voice.soundId = -1;
+            }
+        }
+        // Always a full buffer, so the sink never starves into an underrun
+        return samples * qint64(sizeof(qint16));
+    }
+
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    struct Voice {
+        int soundId = -1;
+        std::shared_ptr<const QByteArray> pcm;
+        qint64 position = 0; // In samples
+        float gain = 1.0f;
+    };
+
+    QMutex mutex;
+    Voice voices[voiceCount];
+    int channels;
+};
+
+// UI sounds decoded to PCM once and mixed through a single long-lived QAudioSink
+class AudioEngine : public QObject {
+    Q_OBJECT
+
+public:
+    AudioEngine(QObject *parent = nullptr) : QObject(parent) {
+        QAudioDevice device = QMediaDevices::defaultAudioOutput();
+        format = device.preferredFormat();
+        format.setSampleFormat(QAudioFormat::Int16);
+        if (!device.isFormatSupported(format)) {
+            format.setSampleRate(48000);
+            format.setChannelCount(2);
+        }
+
+        mixer = new AudioMixerDevice(format.channelCount(), this);
+        mixer->open(QIODevice::ReadOnly);
+
+        sink = new QAudioSink(device, format, this);
+        // Two 10 ms periods keep trigger latency low without underruns
+        sink->setBufferSize(format.bytesForDuration(20000));
+        sink->start(mixer);
+        sink->suspend();
+
+        // Stop pulling silence once nothing has played for a while
+        idleTimer.setInterval(3000);
+        connect(&idleTimer, &QTimer::timeout, this, [this]() {
+            if (mixer->isIdle()) {
+                sink->suspend();
+                idleTimer.stop();
+            }
+        });
+    }
+
+    // One engine per process, shared by every widget that makes a sound
+    static AudioEngine *instance() {
+        static AudioEngine *engine = new AudioEngine(QCoreApplication::instance());
+        return engine;
+    }
+
+    // Decodes the file in the background; plays before it finishes are dropped
+    void load(const QString &name, const QString &path) {
+        if (soundIds.contains(name)) {
+            return;
+        }
+        int soundId = sounds.size();
+        soundIds.insert(name, soundId);
+        sounds.append(nullptr);
+
+        QFile *file = new QFile(path);
+        if (!file->open(QIODevice::ReadOnly)) {
+            qDebug() << "Failed to open sound:" << path;
+            delete file;
+            return;
+        }
+        QAudioDecoder *decoder = new QAudioDecoder(this);
+        file->setParent(decoder);
+        decoder->setAudioFormat(format);
+        decoder->setSourceDevice(file);
+
+        auto pcm = std::make_shared<QByteArray>();
+        connect(decoder, &QAudioDecoder::bufferReady, this, [decoder, pcm]() {
+            QAudioBuffer buffer = decoder->read();
+            pcm->append(buffer.constData<char>(), buffer.byteCount());
+        });
+        connect(decoder, &QAudioDecoder::finished, this, [this, decoder, pcm, soundId]() {
+            sounds[soundId] = pcm;
+            decoder->deleteLater();
+        });
+        connect(decoder, qOverload<QAudioDecoder::Error>(&QAudioDecoder::error), this, [decoder, path]() {
+            qDebug() << "Failed to decode sound:" << path << decoder->errorString();
+            decoder->deleteLater();
+        });
+        decoder->start();
+    }
+
+    void play(const QString &name, float gain = 1.0f) {
+        int soundId = soundIds.value(name, -1);
+        if (soundId < 0 || !sounds[soundId]) {
+            return;
+        }
+        mixer->trigger(soundId, sounds[soundId], gain * volume);
+        if (sink->state() == QAudio::SuspendedState) {
+            sink->resume();
+        }
+        idleTimer.start();
+    }
+
+    void stop(const QString &name) {
+        int soundId = soundIds.value(name, -1);
+        if (soundId >= 0) {
+            mixer->stop(soundId);
+        }
+    }
+
+    void setVolume(float value) { volume = value; }
+
+private:
+    QAudioFormat format;
+    AudioMixerDevice *mixer;
+    QAudioSink *sink;
+    QTimer idleTimer;
+    QHash<QString, int> soundIds;
+    QList<std::shared_ptr<const QByteArray>> sounds;
+    float volume = 1.0f;
+};
+
+#endif // AUDIOENGINE_H
@@ -0,0 +1,137 @@
+#include <QCoreApplication>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QFileInfo>
+#include <QDirIterator>
+#include <QEventLoop>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QRegularExpression>
+#include <QDebug>
+#include "../../hyprlandipc.h"
+#include "../../appimagecache.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+// SIGTERM to the launch's session, SIGKILL for whatever is still there after timeoutMs
+static void stopSession(pid_t sid, int timeoutMs) {
+    kill(-sid, SIGTERM);
+    QElapsedTimer elapsed;
+    elapsed.start();
+    while (kill(-sid, 0) == 0 && elapsed.elapsed() < timeoutMs) {
+        QThread::msleep(20);
+    }
+    kill(-sid, SIGKILL);
+}
+
+// Drops a file, or every file below a directory, from the page cache. Needs the pages to be clean,
+// hence the sync() after extraction.
+static void evict(const QString &path) {
+    QStringList files;
+    if (QFileInfo(path).isDir()) {
+        QDirIterator it(path, QDir::Files | QDir::Hidden | QDir::NoSymLinks, QDirIterator::Subdirectories);
+        while (it.hasNext()) files << it.next();
+    } else {
+        files << path;
+    }
+    for (const QString &file : std::as_const(files)) {
+        int fd = open(QFile::encodeName(file).constData(), O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+    }
+}
+
+// Cold launch-to-first-window time of one AppImage, through FUSE and from its extraction. Before every
+// run the image (or the extraction) is evicted from the page cache, and the two modes alternate, so
+// neither profits from the other or from the hashing and unsquashing just done. Shared system
+// libraries stay cached. Only a window whose class matches windowClass counts, so notifications or
+// other apps opening meanwhile are ignored.
+static int runAppImageBenchmark(const QString &appImage, const QString &windowClass, int runs) {
+    HyprlandIpc ipc;
+    if (!ipc.isAvailable()) {
+        qDebug() << "AppImage benchmark needs a running Hyprland session for openwindow events";
+        return 1;
+    }
+    ipc.connectEvents();
+
+    AppImageCache cache;
+    QElapsedTimer extraction;
+    extraction.start();
+    if (!cache.extractNow(appImage)) {
+        qDebug() << "Could not extract" << appImage;
+        return 1;
+    }
+    qDebug() << "Extraction (or verification) took" << extraction.elapsed() << "ms";
+    QString appRun = cache.cachedAppRun(appImage);
+    sync(); // Dirty pages of the fresh extraction cannot be evicted
+
+    QString hint = windowClass.toLower();
+    auto measure = [&ipc, &hint](const QString &program, const QProcessEnvironment &environment) -> qint64 {
+        QProcess process;
+        process.setProgram(program);
+        process.setProcessEnvironment(environment);
+        process.setChildProcessModifier([]() { ::setsid(); });
+        QEventLoop loop;
+        QElapsedTimer timer;
+        qint64 result = -1;
+        QMetaObject::Connection connection = QObject::connect(&ipc, &HyprlandIpc::windowOpened, &loop,
+                                                              [&](const QString &, const QString &, const QString &cls, const QString &) {
+            QString opened = cls.toLower();
+            if (opened.isEmpty() || (!opened.contains(hint) && !hint.contains(opened))) {
+                return;
+            }
+            result = timer.elapsed();
+            loop.quit();
+        });
+        QTimer::singleShot(60000, &loop, &QEventLoop::quit);
+        timer.start();
+        process.start();
+        loop.exec();
+        QObject::disconnect(connection);
+
+        // Close the whole session before the next run
+        stopSession(pid_t(process.processId()), 3000);
+        process.waitForFinished(1000);
+        QThread::msleep(500);
+        return result;
+    };
+
+    QList<qint64> samples[2];
+    for (int i = 0; i < runs; ++i) {
+        for (int mode = 0; mode < 2; ++mode) {
+            evict(mode == 0 ? appImage : QFileInfo(appRun).absolutePath());
+            qint64 elapsed = mode == 0 ? measure(appImage, QProcessEnvironment::systemEnvironment())
+                                       : measure(appRun, AppImageCache::environment(appImage, appRun));
+            if (elapsed >= 0) samples[mode] << elapsed;
+        }
+    }
+    for (int mode = 0; mode < 2; ++mode) {
+        QList<qint64> &sorted = samples[mode];
+        std::sort(sorted.begin(), sorted.end());
+        qDebug().nospace() << (mode == 0 ? "FUSE mount, cold: " : "Extracted, cold:  ") << sorted.size() << "/" << runs << " windows, median "
+                           << (sorted.isEmpty() ? -1 : sorted[sorted.size() / 2]) << " ms, min " << (sorted.isEmpty() ? -1 : sorted.first()) << " ms";
+    }
+    return 0;
+}
+
+// Arguments: <AppImage> [runs, default 5] [window class, default the image name up to its version]
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    // Same cache as the launcher, so an existing extraction is reused
+    app.setOrganizationName("claudemods");
+    app.setApplicationName("ApexGamester");
+
+    QString appImage = app.arguments().value(1);
+    int runs = qMax(1, app.arguments().value(2, "5").toInt());
+    QString windowClass = app.arguments().value(3, QFileInfo(appImage).completeBaseName().section(QRegularExpression("[-_ .]"), 0, 0));
+    if (appImage.isEmpty() || windowClass.isEmpty()) {
+        qDebug() << "Usage: appimage-benchmark <AppImage> [runs] [window class]";
+        return 1;
+    }
+    return runAppImageBenchmark(appImage, windowClass, runs);
+}
@@ -0,0 +1,15 @@
+# Project Configuration
+TEMPLATE = app
+CONFIG += c++23 console
+CONFIG -= app_bundle
+
+# Target Application Name
+TARGET = appimage-benchmark
+
+# Source Files
+SOURCES += main.cpp
+HEADERS += ../../hyprlandipc.h ../../appimagecache.h
+
+# Qt Modules
+QT += core network
+QT -= gui
@@ -0,0 +1,104 @@
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QProcess>
+#include <QEventLoop>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QBuffer>
+#include <QImage>
+#include <QImageWriter>
+#include <QFile>
+#include <QtConcurrent>
+#include <QDebug>
+#include "../../screenshotpipeline.h"
+#include <algorithm>
+
+// Capture-to-saved latency per format and compression level, plus the longest GUI-thread stall while
+// the worker encodes. Uses grim on the running output when available, otherwise a synthetic 4K frame.
+static int runScreenshotBenchmark(int runs) {
+    QTemporaryDir dir;
+    bool live = !qEnvironmentVariable("WAYLAND_DISPLAY").isEmpty() && !QStandardPaths::findExecutable("grim").isEmpty();
+    QByteArray syntheticPpm;
+    if (!live) {
+        // Gradients plus noise, so the encoders do realistic work rather than compressing a flat fill
+        QImage frame(3840, 2160, QImage::Format_RGB32);
+        quint32 noise = 12345;
+        for (int y = 0; y < frame.height(); ++y) {
+            QRgb *line = reinterpret_cast<QRgb *>(frame.scanLine(y));
+            for (int x = 0; x < frame.width(); ++x) {
+                noise = noise * 1664525u + 1013904223u;
+                line[x] = qRgb((x * 255) / frame.width(), (y * 255) / frame.height(), ((x ^ y) & 0xC0) | (noise >> 28));
+            }
+        }
+        QBuffer buffer(&syntheticPpm);
+        buffer.open(QIODevice::WriteOnly);
+        frame.save(&buffer, "PPM");
+    }
+
+    QList<QString> formats{"png"};
+    if (QImageWriter::supportedImageFormats().contains("webp")) {
+        formats << "webp";
+    }
+    qDebug() << "Screenshot benchmark:" << (live ? "grim capture of the current output" : "synthetic 3840x2160 frame") << "," << runs << "runs each";
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(1);
+    for (const QString &format : formats) {
+        for (int level : {0, 1, 6, 9}) {
+            ScreenshotPipeline::Options options;
+            options.format = format;
+            options.compression = level;
+            options.directory = dir.path();
+            QList<qint64> totals;
+            qint64 bytes = 0;
+            qint64 worstStall = 0;
+            for (int run = 0; run < runs; ++run) {
+                QElapsedTimer total;
+                total.start();
+                QByteArray ppm = syntheticPpm;
+                if (live) {
+                    QProcess grim;
+                    grim.start("grim", {"-t", "ppm", "-"});
+                    grim.waitForFinished(10000);
+                    ppm = grim.readAllStandardOutput();
+                }
+                qint64 captureMs = total.elapsed();
+
+                // The event loop keeps ticking every 5 ms; any gap longer than that is a UI stall
+                QFuture<ScreenshotPipeline::Result> future = QtConcurrent::run(&pool, &ScreenshotPipeline::process, ppm, options, captureMs);
+                QElapsedTimer sinceTick;
+                sinceTick.start();
+                QEventLoop loop;
+                QTimer tick;
+                QObject::connect(&tick, &QTimer::timeout, [&]() {
+                    worstStall = qMax(worstStall, sinceTick.restart());
+                    if (future.isFinished()) loop.quit();
+                });
+                tick.start(5);
+                loop.exec();
+
+                ScreenshotPipeline::Result result = future.result();
+                if (!result.error.isEmpty()) {
+                    qDebug() << format << level << result.error;
+                    return 1;
+                }
+                totals << total.elapsed();
+                bytes += result.encoded.size();
+                QFile::remove(result.path);
+            }
+            std::sort(totals.begin(), totals.end());
+            qDebug().noquote() << QString("%1 level %2: capture-to-saved p50 %3 ms, max %4 ms, %5 KiB, longest UI stall %6 ms")
+                                      .arg(format, 4).arg(level).arg(totals[totals.size() / 2]).arg(totals.last())
+                                      .arg(bytes / runs / 1024).arg(worstStall);
+        }
+    }
+    return 0;
+}
+
+// Optional argument: runs per format and level (default 5)
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    return runScreenshotBenchmark(qMax(1, app.arguments().value(1, "5").toInt()));
+}
@@ -0,0 +1,14 @@
+# Project Configuration
+TEMPLATE = app
+CONFIG += c++23 console
+CONFIG -= app_bundle
+
+# Target Application Name
+TARGET = screenshot-benchmark
+
+# Source Files
+SOURCES += main.cpp
+HEADERS += ../../hyprlandipc.h ../../screenshotpipeline.h
+
+# Qt Modules
+QT += core gui concurrent network
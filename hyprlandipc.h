@@ -0,0 +1,202 @@
+#ifndef HYPRLANDIPC_H
+#define HYPRLANDIPC_H
+
+#include <QObject>
+#include <QCoreApplication>
+#include <QLocalSocket>
+#include <QQueue>
+#include <QPointer>
+#include <QTimer>
+#include <QFile>
+#include <QDebug>
+#include <functional>
+
+// Async client for Hyprland's sockets in $XDG_RUNTIME_DIR/hypr/$HYPRLAND_INSTANCE_SIGNATURE.
+// Hyprland answers one request per connection on .socket.sock, so commands are queued and sent
+// one connection at a time; .socket2.sock stays connected and streams "EVENT>>DATA" lines.
+class HyprlandIpc : public QObject {
+    Q_OBJECT
+
+public:
+    // socketDir is injectable so a fake server can stand in for the compositor
+    explicit HyprlandIpc(const QString &socketDir = defaultSocketDir(), QObject *parent = nullptr)
+    : QObject(parent), socketDir(socketDir), commandSocket(nullptr), eventSocket(nullptr) {
+        commandTimeout.setSingleShot(true);
+        commandTimeout.setInterval(1000);
+        connect(&commandTimeout, &QTimer::timeout, this, [this]() {
+            qDebug() << "Hyprland command timed out:" << current.text;
+            finishCommand();
+        });
+
+        // The compositor may restart; keep trying to get the event stream back
+        reconnectTimer.setSingleShot(true);
+        reconnectTimer.setInterval(2000);
+        connect(&reconnectTimer, &QTimer::timeout, this, &HyprlandIpc::connectEvents);
+    }
+
+    // One client per process for the running compositor
+    static HyprlandIpc *instance() {
+        static HyprlandIpc *ipc = new HyprlandIpc(defaultSocketDir(), QCoreApplication::instance());
+        return ipc;
+    }
+
+    static QString defaultSocketDir() {
+        QString signature = qEnvironmentVariable("HYPRLAND_INSTANCE_SIGNATURE");
+        if (signature.isEmpty()) {
+            return QString();
+        }
+        QString runtimeDir = qEnvironmentVariable("XDG_RUNTIME_DIR");
+        QString dir = runtimeDir + "/hypr/" + signature;
+        if (runtimeDir.isEmpty() || !QFile::exists(dir + "/.socket.sock")) {
+            dir = "/tmp/hypr/" + signature; // Hyprland before 0.40
+        }
+        return dir;
+    }
+
+    bool isAvailable() const {
+        return !socketDir.isEmpty() && QFile::exists(socketDir + "/.socket.sock");
+    }
+
+    void dispatch(const QString &dispatcher) {
+        command("dispatch " + dispatcher);
+    }
+
+    // Raw request, e.g. "dispatch workspace 3" or "j/activewindow"; the reply goes to replyReceived
+    void command(const QString &request) {
+        enqueue({request.toUtf8(), nullptr, nullptr});
+    }
+
+    // The reply goes to callback alone, never to replyReceived, so other users of the same client
+    // sending the same request cannot take it; dropped if context is destroyed first
+    void command(const QString &request, QObject *context, std::function<void(const QByteArray &)> callback) {
+        enqueue({request.toUtf8(), context, std::move(callback)});
+    }
+
+    void connectEvents() {
+        if (socketDir.isEmpty()) {
+            return;
+        }
+        if (!eventSocket) {
+            eventSocket = new QLocalSocket(this);
+            connect(eventSocket, &QLocalSocket::readyRead, this, &HyprlandIpc::readEvents);
+            connect(eventSocket, &QLocalSocket::disconnected, &reconnectTimer, qOverload<>(&QTimer::start));
+            connect(eventSocket, &QLocalSocket::errorOccurred, &reconnectTimer, qOverload<>(&QTimer::start));
+        }
+        if (eventSocket->state() == QLocalSocket::UnconnectedState) {
+            eventBuffer.clear();
+            eventSocket->connectToServer(socketDir + "/.socket2.sock");
+        }
+    }
+
+signals:
+    void replyReceived(const QString &request, const QByteArray &reply);
+    void eventReceived(const QString &name, const QString &data);
+    void windowOpened(const QString &address, const QString &workspace, const QString &windowClass, const QString &title);
+    void windowClosed(const QString &address);
+    void workspaceChanged(const QString &name);
+
+private:
+    struct Request {
+        QByteArray text;
+        QPointer<QObject> context;
+        std::function<void(const QByteArray &)> callback;
+    };
+
+    void enqueue(const Request &request) {
+        if (!isAvailable()) {
+            return;
+        }
+        queue.enqueue(request);
+        if (!commandSocket) {
+            sendNext();
+        }
+    }
+
+    void sendNext() {
+        if (queue.isEmpty()) {
+            return;
+        }
+        current = queue.dequeue();
+        currentReply.clear();
+        commandSocket = new QLocalSocket(this);
+        connect(commandSocket, &QLocalSocket::connected, this, [this]() {
+            commandSocket->write(current.text);
+        });
+        connect(commandSocket, &QLocalSocket::readyRead, this, [this]() {
+            currentReply += commandSocket->readAll();
+        });
+        // Hyprland closes the connection once it has answered
+        connect(commandSocket, &QLocalSocket::disconnected, this, &HyprlandIpc::finishCommand);
+        connect(commandSocket, &QLocalSocket::errorOccurred, this, [this](QLocalSocket::LocalSocketError error) {
+            if (error != QLocalSocket::PeerClosedError) {
+                qDebug() << "Hyprland command failed:" << current.text << commandSocket->errorString();
+            }
+            finishCommand();
+        });
+        commandTimeout.start();
+        commandSocket->connectToServer(socketDir + "/.socket.sock");
+    }
+
+    void finishCommand() {
+        if (!commandSocket) {
+            return;
+        }
+        commandTimeout.stop();
+        QLocalSocket *socket = commandSocket;
+        commandSocket = nullptr;
+        socket->disconnect(this);
+        currentReply += socket->readAll();
+        socket->abort();
+        socket->deleteLater();
+        Request finished = current;
+        current = Request();
+        if (finished.callback) {
+            if (finished.context) finished.callback(currentReply);
+        } else {
+            emit replyReceived(QString::fromUtf8(finished.text), currentReply);
+        }
+        if (!commandSocket) {
+            sendNext(); // A handler above may already have started the next one
+        }
+    }
+
+    void readEvents() {
+        eventBuffer += eventSocket->readAll();
+        int newline;
+        while ((newline = eventBuffer.indexOf('\n')) >= 0) {
+            QString line = QString::fromUtf8(eventBuffer.left(newline));
+            eventBuffer.remove(0, newline + 1);
+            int separator = line.indexOf(">>");
+            if (separator < 0) {
+                continue;
+            }
+            QString name = line.left(separator);
+            QString data = line.mid(separator + 2);
+            emit eventReceived(name, data);
+
+            if (name == "openwindow") {
+                // ADDRESS,WORKSPACE,CLASS,TITLE; the title may itself contain commas
+                QStringList fields = data.split(',');
+                if (fields.size() >= 4) {
+                    emit windowOpened(fields[0], fields[1], fields[2], fields.mid(3).join(','));
+                }
+            } else if (name == "closewindow") {
+                emit windowClosed(data);
+            } else if (name == "workspace") {
+                emit workspaceChanged(data);
+            }
+        }
+    }
+
+    QString socketDir;
+    QQueue<Request> queue;
+    QLocalSocket *commandSocket; // In-flight request, if any
+    Request current;
+    QByteArray currentReply;
+    QTimer commandTimeout;
+    QLocalSocket *eventSocket;
+    QByteArray eventBuffer;
+    QTimer reconnectTimer;
+};
+
+#endif // HYPRLANDIPC_H
@@ -17,8 +17,8 @@
 #include <QTabBar>
 #include <QDebug>
 #include <QFileInfo>
-#include <QMediaPlayer> // For sound playback
-#include <QAudioOutput> // For audio output
+#include "../audioengine.h" // Shared preloaded UI sounds
+#include "../hyprlandipc.h" // Workspace switches without hyprctl
 #include <QFile> // For file operations
 #include <QTextStream> // For writing to files
 
@@ -108,12 +108,8 @@ public:
         // Set initial size (larger by default)
         scaleImage(largeSize);
 
-        // Initialize media player for hover sound
-        mediaPlayer = new QMediaPlayer(this);
-        audioOutput = new QAudioOutput(this);
-        mediaPlayer->setAudioOutput(audioOutput);
-        mediaPlayer->setSource(QUrl::fromLocalFile("/opt/claudemods-ApexTools/sounds/hover.mp3"));
-        audioOutput->setVolume(50); // Set volume (0-100)
+        // Hover sound is decoded once and shared by every button
+        AudioEngine::instance()->load("hover", "/opt/claudemods-ApexTools/sounds/hover.mp3");
     }
 
 signals:
@@ -124,14 +120,14 @@ protected:
         Q_UNUSED(event);
         glowEffect->setEnabled(true); // Enable glow on hover
         scaleImage(largeSizeHover); // Enlarge image further on hover
-        mediaPlayer->play(); // Play hover sound
+        AudioEngine::instance()->play("hover"); // Play hover sound
     }
 
     void leaveEvent(QEvent *event) override {
         Q_UNUSED(event);
         glowEffect->setEnabled(false); // Disable glow when not hovering
         scaleImage(largeSize); // Restore to default larger size
-        mediaPlayer->stop(); // Stop hover sound
+        AudioEngine::instance()->stop("hover"); // Stop hover sound
     }
 
     void mousePressEvent(QMouseEvent *event) override {
@@ -150,8 +146,6 @@ private:
     QString labelText;
     QLabel *imageLabel;
     QGraphicsDropShadowEffect *glowEffect;
-    QMediaPlayer *mediaPlayer;
-    QAudioOutput *audioOutput;
 
     // Define sizes for default and hover states
     QSize largeSize = QSize(200, 200); // Default larger size
@@ -314,8 +308,9 @@ private:
 
     void launchArchInstaller() {
         // Launch ArchInstaller script
+        HyprlandIpc::instance()->dispatch("workspace 3");
         QProcess *process = new QProcess(this);
-        process->start("bash", QStringList() << "-c" << "hyprctl dispatch workspace 3 && /usr/bin/apexinstallgui");
+        process->start("/usr/bin/apexinstallgui", QStringList());
 
         // Handle process completion
         connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, process](int exitCode, QProcess::ExitStatus exitStatus) {
@@ -485,8 +480,9 @@ private slots:
     }
 
     void launchIsoCreator() {
+        HyprlandIpc::instance()->dispatch("workspace 2");
         QProcess *process = new QProcess(this);
-        process->start("bash", QStringList() << "-c" << "hyprctl dispatch workspace 2 && /usr/bin/apexisocreatorgui");
+        process->start("/usr/bin/apexisocreatorgui", QStringList());
         connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, process](int exitCode, QProcess::ExitStatus exitStatus) {
             if (exitStatus == QProcess::CrashExit || exitCode != 0) {
                 QMessageBox::critical(this, "Error", "Failed to start Iso Creator.");
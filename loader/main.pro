@@ -7,5 +7,6 @@ TARGET = ApexLoad.bin
 
 # Source Files
 SOURCES += main.cpp
+HEADERS += ../audioengine.h ../hyprlandipc.h
 # Qt Modules
-QT += core gui widgets 
+QT += core gui widgets multimedia network
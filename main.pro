@@ -1,14 +1,18 @@
 # Project Configuration
 TEMPLATE = app
-CONFIG += c++23
+CONFIG += c++23 link_pkgconfig
 
 # Target Application Name
 TARGET = apexgamester.bin
 
 # Source Files
 SOURCES += main.cpp
+HEADERS += audioengine.h hyprlandipc.h pulsevolume.h replaybuffer.h screenshotpipeline.h appimagecache.h
 
 # Qt Modules
-QT += core gui widgets multimedia multimediawidgets webenginewidgets webenginecore webenginequick
+QT += core gui widgets concurrent multimedia multimediawidgets webenginewidgets webenginecore webenginequick network
+
+# System Libraries
+PKGCONFIG += libpulse
 
 RESOURCES += resources.qrc
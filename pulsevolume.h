@@ -0,0 +1,195 @@
+#ifndef PULSEVOLUME_H
+#define PULSEVOLUME_H
+
+#include <QObject>
+#include <QTimer>
+#include <QDebug>
+#include <pulse/pulseaudio.h>
+
+// Default-sink volume over one long-lived libpulse connection (PulseAudio or pipewire-pulse).
+// Slider moves are coalesced to at most one write per frame and never overlap an unfinished write;
+// sink and server events keep the reported level in step with changes made elsewhere.
+class PulseVolume : public QObject {
+    Q_OBJECT
+
+public:
+    struct Stats {
+        int requests = 0; // setVolume calls
+        int writes = 0;   // Volume writes actually sent
+        int updates = 0;  // Sink states received
+    };
+
+    // server is injectable so a private daemon can stand in for the session's; empty means the default
+    explicit PulseVolume(const QString &server = QString(), QObject *parent = nullptr)
+    : QObject(parent), server(server.toUtf8()) {
+        flushTimer.setSingleShot(true);
+        flushTimer.setInterval(16);
+        connect(&flushTimer, &QTimer::timeout, this, &PulseVolume::flush);
+
+        // The sound server may restart underneath us
+        reconnectTimer.setSingleShot(true);
+        reconnectTimer.setInterval(2000);
+        connect(&reconnectTimer, &QTimer::timeout, this, &PulseVolume::connectToServer);
+
+        mainloop = pa_threaded_mainloop_new();
+        pa_threaded_mainloop_start(mainloop);
+        connectToServer();
+    }
+
+    ~PulseVolume() override {
+        pa_threaded_mainloop_lock(mainloop);
+        dropContext();
+        pa_threaded_mainloop_unlock(mainloop);
+        pa_threaded_mainloop_stop(mainloop);
+        pa_threaded_mainloop_free(mainloop);
+    }
+
+    bool isAvailable() const { return available; }
+    int volume() const { return currentPercent; }
+    const Stats &statistics() const { return stats; }
+
+    void setVolume(int percent) {
+        stats.requests++;
+        pendingPercent = qBound(0, percent, 150);
+        if (!flushTimer.isActive()) {
+            flushTimer.start();
+        }
+    }
+
+signals:
+    void volumeChanged(int percent, bool muted);
+    void availabilityChanged(bool available);
+
+private:
+    void connectToServer() {
+        pa_threaded_mainloop_lock(mainloop);
+        dropContext();
+        context = pa_context_new(pa_threaded_mainloop_get_api(mainloop), "ApexGamester");
+        pa_context_set_state_callback(context, &PulseVolume::contextState, this);
+        bool started = pa_context_connect(context, server.isEmpty() ? nullptr : server.constData(), PA_CONTEXT_NOAUTOSPAWN, nullptr) >= 0;
+        if (!started) {
+            dropContext();
+        }
+        pa_threaded_mainloop_unlock(mainloop);
+        if (!started) {
+            reconnectTimer.start();
+        }
+    }
+
+    // Called with the mainloop locked
+    void dropContext() {
+        if (writeOperation) {
+            pa_operation_unref(writeOperation);
+            writeOperation = nullptr;
+        }
+        if (context) {
+            pa_context_set_state_callback(context, nullptr, nullptr);
+            pa_context_set_subscribe_callback(context, nullptr, nullptr);
+            pa_context_disconnect(context);
+            pa_context_unref(context);
+            context = nullptr;
+        }
+        sinkIndex = PA_INVALID_INDEX;
+    }
+
+    void flush() {
+        if (pendingPercent < 0) {
+            return;
+        }
+        pa_threaded_mainloop_lock(mainloop);
+        bool ready = context && pa_context_get_state(context) == PA_CONTEXT_READY && sinkIndex != PA_INVALID_INDEX;
+        bool busy = writeOperation && pa_operation_get_state(writeOperation) == PA_OPERATION_RUNNING;
+        if (ready && !busy) {
+            if (writeOperation) {
+                pa_operation_unref(writeOperation);
+            }
+            // Scaling keeps the channel balance the user set elsewhere
+            pa_cvolume_scale(&sinkVolume, pa_volume_t(qint64(pendingPercent) * PA_VOLUME_NORM / 100));
+            writeOperation = pa_context_set_sink_volume_by_index(context, sinkIndex, &sinkVolume, nullptr, nullptr);
+            pendingPercent = -1;
+            stats.writes++;
+        }
+        pa_threaded_mainloop_unlock(mainloop);
+        if (busy) {
+            flushTimer.start(); // Latest value goes out once the server has caught up
+        }
+    }
+
+    // The callbacks below run on the libpulse thread with the mainloop locked
+    static void contextState(pa_context *context, void *userdata) {
+        PulseVolume *self = static_cast<PulseVolume *>(userdata);
+        switch (pa_context_get_state(context)) {
+        case PA_CONTEXT_READY:
+            pa_context_set_subscribe_callback(context, &PulseVolume::subscriptionEvent, self);
+            pa_operation_unref(pa_context_subscribe(context, pa_subscription_mask_t(PA_SUBSCRIPTION_MASK_SINK | PA_SUBSCRIPTION_MASK_SERVER), nullptr, nullptr));
+            pa_operation_unref(pa_context_get_server_info(context, &PulseVolume::serverInfo, self));
+            QMetaObject::invokeMethod(self, [self]() {
+                self->available = true;
+                emit self->availabilityChanged(true);
+            }, Qt::QueuedConnection);
+            break;
+        case PA_CONTEXT_FAILED:
+        case PA_CONTEXT_TERMINATED:
+            QMetaObject::invokeMethod(self, [self]() {
+                qDebug() << "Lost connection to the sound server; retrying";
+                self->available = false;
+                emit self->availabilityChanged(false);
+                self->reconnectTimer.start();
+            }, Qt::QueuedConnection);
+            break;
+        default:
+            break;
+        }
+    }
+
+    static void subscriptionEvent(pa_context *context, pa_subscription_event_type_t type, uint32_t index, void *userdata) {
+        PulseVolume *self = static_cast<PulseVolume *>(userdata);
+        int facility = type & PA_SUBSCRIPTION_EVENT_FACILITY_MASK;
+        if (facility == PA_SUBSCRIPTION_EVENT_SERVER) {
+            // The default sink may have moved, e.g. headphones plugged in
+            pa_operation_unref(pa_context_get_server_info(context, &PulseVolume::serverInfo, self));
+        } else if (facility == PA_SUBSCRIPTION_EVENT_SINK && index == self->sinkIndex
+                   && (type & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_CHANGE) {
+            pa_operation_unref(pa_context_get_sink_info_by_index(context, index, &PulseVolume::sinkInfo, self));
+        }
+    }
+
+    static void serverInfo(pa_context *context, const pa_server_info *info, void *userdata) {
+        if (info && info->default_sink_name) {
+            pa_operation_unref(pa_context_get_sink_info_by_name(context, info->default_sink_name, &PulseVolume::sinkInfo, userdata));
+        }
+    }
+
+    static void sinkInfo(pa_context *, const pa_sink_info *info, int eol, void *userdata) {
+        if (eol != 0 || !info) {
+            return;
+        }
+        PulseVolume *self = static_cast<PulseVolume *>(userdata);
+        self->sinkIndex = info->index;
+        self->sinkVolume = info->volume;
+        int percent = int((quint64(pa_cvolume_max(&info->volume)) * 100 + PA_VOLUME_NORM / 2) / PA_VOLUME_NORM);
+        bool muted = info->mute;
+        QMetaObject::invokeMethod(self, [self, percent, muted]() {
+            self->currentPercent = percent;
+            self->stats.updates++;
+            emit self->volumeChanged(percent, muted);
+        }, Qt::QueuedConnection);
+    }
+
+    QByteArray server;
+    pa_threaded_mainloop *mainloop = nullptr;
+    // Guarded by the mainloop lock
+    pa_context *context = nullptr;
+    pa_operation *writeOperation = nullptr;
+    uint32_t sinkIndex = PA_INVALID_INDEX;
+    pa_cvolume sinkVolume{};
+    // GUI thread only
+    QTimer flushTimer;
+    QTimer reconnectTimer;
+    int pendingPercent = -1;
+    int currentPercent = -1;
+    bool available = false;
+    Stats stats;
+};
+
+#endif // PULSEVOLUME_H
@@ -0,0 +1,254 @@
+#ifndef REPLAYBUFFER_H
+#define REPLAYBUFFER_H
+
+#include <QObject>
+#include <QCoreApplication>
+#include <QProcess>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QQueue>
+#include <QTextStream>
+#include <QDateTime>
+#include <QRect>
+#include <unistd.h>
+
+// Instant replay: ffmpeg encodes continuously into short MPEG-TS segments in a tmpfs ring, and the
+// oldest finished segments are unlinked whenever the ring exceeds its byte budget or the kept length.
+// Saving hard-links the retained segments (so the ring can keep rotating) and stream-copies them
+// into one faststart MP4. Memory use is the ring plus one encoder, independent of session length.
+class ReplayBuffer : public QObject {
+    Q_OBJECT
+
+public:
+    struct Config {
+        int keepSeconds = 60;
+        qint64 budgetBytes = 256ll * 1024 * 1024;
+        int segmentSeconds = 2;
+        int fps = 60;
+        int threads = 2; // Kept small: this runs alongside the game the whole time
+        QString audioSource = "@DEFAULT_MONITOR@"; // What the game plays; empty for video only
+    };
+
+    ReplayBuffer(QObject *parent = nullptr) : QObject(parent) {}
+
+    ~ReplayBuffer() override {
+        blockSignals(true);
+        stop();
+        if (saver) {
+            saver->waitForFinished(10000);
+        }
+    }
+
+    // tmpfs, so the ring never touches the disk
+    static QString ringLocation() {
+        QString runtimeDir = qEnvironmentVariable("XDG_RUNTIME_DIR");
+        return (runtimeDir.isEmpty() ? QString("/dev/shm") : runtimeDir) + QString("/apex-replay-%1").arg(QCoreApplication::applicationPid());
+    }
+
+    static QStringList screenInput(const QRect &geometry, int fps) {
+        return {"-f", "x11grab", "-framerate", QString::number(fps), "-draw_mouse", "1",
+                "-video_size", QString("%1x%2").arg(geometry.width()).arg(geometry.height()),
+                "-i", qEnvironmentVariable("DISPLAY", ":0") + QString("+%1,%2").arg(geometry.x()).arg(geometry.y())};
+    }
+
+    bool isRunning() const { return encoder != nullptr; }
+    qint64 ringBytes() const { return bytes; }
+    qint64 retainedMs() const { return retained; }
+    pid_t encoderPid() const { return encoder ? pid_t(encoder->processId()) : 0; }
+
+    // input is the ffmpeg input part, e.g. screenInput() or a lavfi test source
+    bool start(const QStringList &input, const Config &settings, const QString &outputDir) {
+        if (encoder) {
+            return true;
+        }
+        config = settings;
+        saveDir = outputDir;
+        ringDir = ringLocation();
+        QDir(ringDir).removeRecursively();
+        if (!QDir().mkpath(ringDir)) {
+            emit failed("Cannot create " + ringDir);
+            return false;
+        }
+
+        // Bitrate capped so a full window of segments fits the budget with one segment to spare
+        qint64 windowSeconds = config.keepSeconds + 2 * config.segmentSeconds;
+        qint64 maxBitrate = qMax<qint64>(500000, config.budgetBytes * 8 / windowSeconds * 9 / 10);
+        QStringList args{"-hide_banner", "-loglevel", "error", "-nostats"};
+        args << input;
+        if (!config.audioSource.isEmpty()) {
+            args << "-thread_queue_size" << "1024" << "-f" << "pulse" << "-i" << config.audioSource;
+        }
+        args << "-c:v" << "libx264" << "-preset" << "ultrafast" << "-tune" << "zerolatency" << "-crf" << "23"
+             << "-maxrate" << QString::number(maxBitrate) << "-bufsize" << QString::number(maxBitrate)
+             << "-pix_fmt" << "yuv420p" << "-threads" << QString::number(config.threads)
+             << "-g" << QString::number(config.fps * config.segmentSeconds)
+             << "-force_key_frames" << QString("expr:gte(t,n_forced*%1)").arg(config.segmentSeconds);
+        if (!config.audioSource.isEmpty()) {
+            args << "-c:a" << "aac" << "-b:a" << "128k";
+        }
+        // Each finished segment is announced as "file,start,end" on stdout
+        args << "-f" << "segment" << "-segment_time" << QString::number(config.segmentSeconds)
+             << "-segment_format" << "mpegts" << "-segment_list" << "pipe:1" << "-segment_list_type" << "csv"
+             << "-reset_timestamps" << "1" << ringDir + "/segment-%08d.ts";
+
+        QProcess *process = new QProcess(this);
+        process->setWorkingDirectory(ringDir);
+        connect(process, &QProcess::readyReadStandardOutput, this, &ReplayBuffer::readSegments);
+        connect(process, &QProcess::finished, this, [this, process]() {
+            QByteArray errors = process->readAllStandardError().trimmed();
+            process->deleteLater();
+            if (process != encoder) {
+                return;
+            }
+            encoder = nullptr;
+            emit failed("Instant replay stopped unexpectedly" + (errors.isEmpty() ? QString() : ": " + QString::fromUtf8(errors.split('\n').last())));
+            emit runningChanged(false);
+        });
+        process->start("ffmpeg", args);
+        if (!process->waitForStarted(3000)) {
+            emit failed("ffmpeg could not be started: " + process->errorString());
+            process->deleteLater();
+            QDir(ringDir).removeRecursively();
+            return false;
+        }
+        encoder = process;
+        emit runningChanged(true);
+        return true;
+    }
+
+    void stop() {
+        if (!encoder) {
+            return;
+        }
+        QProcess *process = encoder;
+        encoder = nullptr;
+        process->disconnect(this);
+        process->write("q");
+        process->closeWriteChannel();
+        if (!process->waitForFinished(2000)) {
+            process->kill();
+            process->waitForFinished();
+        }
+        process->deleteLater();
+        ring.clear();
+        bytes = 0;
+        retained = 0;
+        lineBuffer.clear();
+        if (!saver) {
+            QDir(ringDir).removeRecursively(); // A running save holds its own links outside the ring
+        }
+        emit runningChanged(false);
+    }
+
+    // Stitches the newest finished segments covering `seconds` into saveDir, without re-encoding
+    bool save(int seconds = 0) {
+        if (seconds <= 0) {
+            seconds = config.keepSeconds;
+        }
+        if (saver || ring.isEmpty()) {
+            return false;
+        }
+        QString stamp = QDateTime::currentDateTime().toString("yyyy-MM-dd_HH-mm-ss");
+        QString linkDir = ringDir + "-save-" + stamp;
+        QDir().mkpath(linkDir);
+        QDir().mkpath(saveDir);
+
+        int first = int(ring.size());
+        qint64 covered = 0;
+        while (first > 0 && covered < seconds * 1000ll) {
+            covered += ring[--first].durationMs;
+        }
+        QFile list(linkDir + "/segments.txt");
+        if (!list.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            return false;
+        }
+        QTextStream out(&list);
+        for (int i = first; i < ring.size(); ++i) {
+            QString link = linkDir + "/" + QFileInfo(ring[i].path).fileName();
+            if (::link(QFile::encodeName(ring[i].path).constData(), QFile::encodeName(link).constData()) != 0) {
+                QFile::copy(ring[i].path, link); // Different filesystems
+            }
+            out << "file '" << QString(link).replace("'", "'\\''") << "'\n";
+        }
+        out.flush();
+        list.close();
+
+        QString output = saveDir + "/Replay-" + stamp + ".mp4";
+        saver = new QProcess(this);
+        connect(saver, &QProcess::finished, this, [this, output, linkDir, covered](int exitCode) {
+            QByteArray errors = saver->readAllStandardError().trimmed();
+            saver->deleteLater();
+            saver = nullptr;
+            QDir(linkDir).removeRecursively();
+            if (!encoder) {
+                QDir(ringDir).removeRecursively();
+            }
+            if (exitCode == 0 && QFileInfo(output).size() > 0) {
+                emit saved(output, covered);
+            } else {
+                emit failed("Could not save the replay" + (errors.isEmpty() ? QString() : ": " + QString::fromUtf8(errors)));
+            }
+        });
+        saver->start("ffmpeg", {"-hide_banner", "-loglevel", "error", "-f", "concat", "-safe", "0", "-i", list.fileName(),
+                                "-c", "copy", "-movflags", "+faststart", "-y", output});
+        return true;
+    }
+
+signals:
+    void runningChanged(bool running);
+    void saved(const QString &path, qint64 durationMs);
+    void failed(const QString &message);
+
+private:
+    struct Segment {
+        QString path;
+        qint64 size = 0;
+        qint64 durationMs = 0;
+    };
+
+    void readSegments() {
+        if (!encoder) {
+            return;
+        }
+        lineBuffer += encoder->readAllStandardOutput();
+        int newline;
+        while ((newline = lineBuffer.indexOf('\n')) >= 0) {
+            QList<QByteArray> fields = lineBuffer.left(newline).trimmed().split(',');
+            lineBuffer.remove(0, newline + 1);
+            if (fields.size() < 3) {
+                continue;
+            }
+            Segment segment;
+            segment.path = QFileInfo(QString::fromUtf8(fields[0])).isAbsolute() ? QString::fromUtf8(fields[0]) : ringDir + "/" + QString::fromUtf8(fields[0]);
+            segment.size = QFileInfo(segment.path).size();
+            segment.durationMs = qint64((fields[2].toDouble() - fields[1].toDouble()) * 1000);
+            ring.enqueue(segment);
+            bytes += segment.size;
+            retained += segment.durationMs;
+        }
+        trim();
+    }
+
+    // Oldest first, but always leave the newest segment
+    void trim() {
+        while (ring.size() > 1 && (bytes > config.budgetBytes || retained - ring.head().durationMs >= config.keepSeconds * 1000ll)) {
+            Segment oldest = ring.dequeue();
+            QFile::remove(oldest.path);
+            bytes -= oldest.size;
+            retained -= oldest.durationMs;
+        }
+    }
+
+    Config config;
+    QString ringDir;
+    QString saveDir;
+    QProcess *encoder = nullptr;
+    QProcess *saver = nullptr;
+    QQueue<Segment> ring;
+    qint64 bytes = 0;    // Finished segments on tmpfs
+    qint64 retained = 0; // Their total length, ms
+    QByteArray lineBuffer;
+};
+
+#endif // REPLAYBUFFER_H
@@ -0,0 +1,231 @@
+#ifndef SCREENSHOTPIPELINE_H
+#define SCREENSHOTPIPELINE_H
+
+#include <QObject>
+#include <QProcess>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QImage>
+#include <QImageWriter>
+#include <QBuffer>
+#include <QDir>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QSet>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QtConcurrent>
+#include <QDebug>
+#include "hyprlandipc.h"
+
+// Screenshots without dialogs: grim writes the capture to stdout as PPM, so nothing touches the disk
+// before encoding; slurp picks a region, or one of the visible windows Hyprland reports. Decoding,
+// PNG/WebP encoding, saving and the clipboard payload all happen on a worker thread.
+class ScreenshotPipeline : public QObject {
+    Q_OBJECT
+
+public:
+    enum Mode { FullScreen, Window, Region };
+
+    struct Options {
+        QString format = "png"; // png or webp
+        int compression = 1;    // 0 (fastest, largest) to 9 (slowest, smallest); WebP 0 is lossless
+        QString directory;
+    };
+
+    struct Result {
+        QString path;
+        QString error;
+        QSize size;
+        QByteArray encoded;
+        QByteArray clipboardPng;
+        qint64 captureMs = 0;
+        qint64 encodeMs = 0; // Decode, encode and save
+        qint64 totalMs = 0;
+    };
+
+    ScreenshotPipeline(HyprlandIpc *ipc, QObject *parent = nullptr) : QObject(parent), ipc(ipc) {
+        pool.setMaxThreadCount(1);
+    }
+
+    ~ScreenshotPipeline() override {
+        pool.waitForDone();
+    }
+
+    void capture(Mode mode, const Options &options) {
+        if (busy) {
+            return;
+        }
+        busy = true;
+        pending = options;
+        started.start();
+        if (mode == FullScreen) {
+            grab(QString());
+        } else if (mode == Window && ipc->isAvailable()) {
+            requestWindows();
+        } else {
+            select(QByteArray());
+        }
+    }
+
+    // Runs on the worker; also used directly by the benchmark
+    static Result process(const QByteArray &ppm, const Options &options, qint64 captureMs) {
+        QElapsedTimer timer;
+        timer.start();
+        Result result;
+        result.captureMs = captureMs;
+
+        QImage image;
+        if (!image.loadFromData(ppm, "PPM")) {
+            result.error = "The capture could not be decoded";
+            return result;
+        }
+        result.size = image.size();
+
+        QString format = options.format;
+        if (format == "webp" && !QImageWriter::supportedImageFormats().contains("webp")) {
+            format = "png"; // Needs the Qt image formats plugin
+        }
+        int level = qBound(0, options.compression, 9);
+        result.encoded = encode(image, format, level);
+        if (result.encoded.isEmpty()) {
+            result.error = "Could not encode the screenshot as " + format;
+            return result;
+        }
+
+        QDir().mkpath(options.directory);
+        result.path = options.directory + "/Screenshot-" + QDateTime::currentDateTime().toString("yyyy-MM-dd_HH-mm-ss-zzz") + "." + format;
+        QSaveFile file(result.path);
+        if (!file.open(QIODevice::WriteOnly) || file.write(result.encoded) != result.encoded.size() || !file.commit()) {
+            result.error = "Could not save " + result.path;
+            return result;
+        }
+        result.encodeMs = timer.elapsed();
+
+        // Every paste target understands PNG; encode it here so a paste never encodes on the GUI thread
+        result.clipboardPng = format == "png" ? result.encoded : encode(image, "png", 1);
+        return result;
+    }
+
+signals:
+    void finished(const ScreenshotPipeline::Result &result);
+
+private:
+    static QByteArray encode(const QImage &image, const QString &format, int level) {
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        QImageWriter writer(&buffer, format.toLatin1());
+        // Qt maps PNG quality 100..0 onto zlib levels 0..9; WebP quality 100 is lossless
+        writer.setQuality(format == "png" ? 100 - (level * 91 + 8) / 9 : 100 - level * 5);
+        if (!writer.write(image)) {
+            qDebug() << "Screenshot encoding failed:" << writer.errorString();
+            return QByteArray();
+        }
+        return data;
+    }
+
+    // Visible windows on every monitor's active workspaces, offered to slurp as the only choices.
+    // Replies come back through callbacks in request order, so other users of the client never see them.
+    void requestWindows() {
+        ipc->command("j/monitors", this, [this](const QByteArray &reply) { monitorsReply = reply; });
+        ipc->command("j/clients", this, [this](const QByteArray &reply) {
+            QSet<int> visible;
+            for (const QJsonValue &monitor : QJsonDocument::fromJson(monitorsReply).array()) {
+                visible.insert(monitor["activeWorkspace"]["id"].toInt());
+                visible.insert(monitor["specialWorkspace"]["id"].toInt());
+            }
+            QByteArray boxes;
+            for (const QJsonValue &client : QJsonDocument::fromJson(reply).array()) {
+                if (!client["mapped"].toBool() || client["hidden"].toBool() || !visible.contains(client["workspace"]["id"].toInt())) {
+                    continue;
+                }
+                QJsonArray at = client["at"].toArray();
+                QJsonArray size = client["size"].toArray();
+                boxes += QString("%1,%2 %3x%4\n").arg(at[0].toInt()).arg(at[1].toInt()).arg(size[0].toInt()).arg(size[1].toInt()).toUtf8();
+            }
+            select(boxes);
+        });
+    }
+
+    // With boxes, slurp only accepts a click on one of them
+    void select(const QByteArray &boxes) {
+        QProcess *slurp = new QProcess(this);
+        connect(slurp, &QProcess::finished, this, [this, slurp](int exitCode) {
+            QString geometry = QString::fromUtf8(slurp->readAllStandardOutput()).trimmed();
+            slurp->deleteLater();
+            if (exitCode != 0 || geometry.isEmpty()) {
+                busy = false; // Cancelled with Escape
+                return;
+            }
+            started.start(); // Time spent choosing is not capture latency
+            grab(geometry);
+        });
+        connect(slurp, &QProcess::errorOccurred, this, [this, slurp](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) {
+                slurp->deleteLater();
+                fail("slurp is not installed");
+            }
+        });
+        slurp->start("slurp", boxes.isEmpty() ? QStringList() : QStringList{"-r"});
+        if (!boxes.isEmpty()) {
+            slurp->write(boxes);
+        }
+        slurp->closeWriteChannel();
+    }
+
+    void grab(const QString &geometry) {
+        QProcess *grim = new QProcess(this);
+        connect(grim, &QProcess::finished, this, [this, grim](int exitCode) {
+            QByteArray ppm = grim->readAllStandardOutput();
+            QByteArray errors = grim->readAllStandardError().trimmed();
+            grim->deleteLater();
+            if (exitCode != 0 || ppm.isEmpty()) {
+                fail("Capture failed" + (errors.isEmpty() ? QString() : ": " + QString::fromUtf8(errors)));
+                return;
+            }
+            qint64 captureMs = started.elapsed();
+            Options options = pending;
+            QElapsedTimer total = started;
+            QPointer<ScreenshotPipeline> self(this);
+            (void)QtConcurrent::run(&pool, [self, ppm, options, captureMs, total]() {
+                Result result = process(ppm, options, captureMs);
+                result.totalMs = total.elapsed();
+                QMetaObject::invokeMethod(self, [self, result]() {
+                    if (!self) return;
+                    self->busy = false;
+                    emit self->finished(result);
+                }, Qt::QueuedConnection);
+            });
+        });
+        connect(grim, &QProcess::errorOccurred, this, [this, grim](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) {
+                grim->deleteLater();
+                fail("grim is not installed");
+            }
+        });
+        QStringList args{"-t", "ppm"};
+        if (!geometry.isEmpty()) {
+            args << "-g" << geometry;
+        }
+        grim->start("grim", args << "-");
+    }
+
+    void fail(const QString &message) {
+        busy = false;
+        Result result;
+        result.error = message;
+        emit finished(result);
+    }
+
+    HyprlandIpc *ipc;
+    QThreadPool pool;
+    QElapsedTimer started;
+    Options pending;
+    bool busy = false;
+    QByteArray monitorsReply;
+};
+
+#endif // SCREENSHOTPIPELINE_H
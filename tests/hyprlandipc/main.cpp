@@ -0,0 +1,75 @@
+#include <QCoreApplication>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTemporaryDir>
+#include <QEventLoop>
+#include <QTimer>
+#include <QDebug>
+#include "../../hyprlandipc.h"
+
+// Exercises HyprlandIpc against a fake compositor in a temporary directory; no Hyprland needed
+static int runHyprlandIpcSelfTest() {
+    QTemporaryDir dir;
+    QLocalServer commandServer;
+    QLocalServer eventServer;
+    if (!dir.isValid() || !commandServer.listen(dir.path() + "/.socket.sock") || !eventServer.listen(dir.path() + "/.socket2.sock")) {
+        qDebug() << "Self-test: cannot create fake Hyprland sockets";
+        return 1;
+    }
+
+    QStringList received;
+    QObject::connect(&commandServer, &QLocalServer::newConnection, [&commandServer, &received]() {
+        QLocalSocket *client = commandServer.nextPendingConnection();
+        QObject::connect(client, &QLocalSocket::readyRead, client, [client, &received]() {
+            received << QString::fromUtf8(client->readAll());
+            client->write("ok");
+            client->disconnectFromServer();
+        });
+    });
+    QObject::connect(&eventServer, &QLocalServer::newConnection, [&eventServer]() {
+        QLocalSocket *client = eventServer.nextPendingConnection();
+        // Split mid-line to check that partial reads are buffered
+        client->write("workspace>>3\nopenwindow>>5a1b,3,kitty,Title, with comma\nclose");
+        client->flush();
+        QTimer::singleShot(50, client, [client]() { client->write("window>>5a1b\n"); });
+    });
+
+    HyprlandIpc ipc(dir.path());
+    int replies = 0;
+    QString workspace, windowClass, windowTitle, closedAddress;
+    QObject::connect(&ipc, &HyprlandIpc::replyReceived, [&replies](const QString &, const QByteArray &reply) {
+        if (reply == "ok") replies++;
+    });
+    QObject::connect(&ipc, &HyprlandIpc::workspaceChanged, [&workspace](const QString &name) { workspace = name; });
+    QObject::connect(&ipc, &HyprlandIpc::windowOpened, [&windowClass, &windowTitle](const QString &, const QString &, const QString &cls, const QString &title) {
+        windowClass = cls;
+        windowTitle = title;
+    });
+    QObject::connect(&ipc, &HyprlandIpc::windowClosed, [&closedAddress](const QString &address) { closedAddress = address; });
+
+    ipc.connectEvents();
+    ipc.dispatch("workspace 3");
+    ipc.dispatch("workspace 2");
+    // Its reply must reach only the callback, not replyReceived
+    QByteArray callbackReply;
+    ipc.command("j/clients", &ipc, [&callbackReply](const QByteArray &reply) { callbackReply = reply; });
+
+    QEventLoop loop;
+    QTimer::singleShot(2000, &loop, &QEventLoop::quit);
+    QTimer poll;
+    QObject::connect(&poll, &QTimer::timeout, [&]() {
+        if (replies == 2 && callbackReply == "ok" && !closedAddress.isEmpty()) loop.quit();
+    });
+    poll.start(10);
+    loop.exec();
+
+    bool passed = received == QStringList{"dispatch workspace 3", "dispatch workspace 2", "j/clients"} && replies == 2 && callbackReply == "ok"
+                  && workspace == "3" && windowClass == "kitty" && windowTitle == "Title, with comma" && closedAddress == "5a1b";
+    qDebug() << "Hyprland IPC self-test" << (passed ? "passed" : "FAILED") << received << workspace << windowClass << windowTitle << closedAddress;
+    return passed ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    return runHyprlandIpcSelfTest();
+}
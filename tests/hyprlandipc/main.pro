@@ -0,0 +1,15 @@
+# Project Configuration
+TEMPLATE = app
+CONFIG += c++23 console
+CONFIG -= app_bundle
+
+# Target Application Name
+TARGET = hyprlandipc-selftest
+
+# Source Files
+SOURCES += main.cpp
+HEADERS += ../../hyprlandipc.h
+
+# Qt Modules
+QT += core network
+QT -= gui
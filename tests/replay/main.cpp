@@ -0,0 +1,111 @@
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDebug>
+#include "../../replaybuffer.h"
+
+// Runs the replay ring headless on a lavfi test source and checks that tmpfs use, encoder memory and
+// CPU stay flat over the run, then that a save stitches the retained window into a playable file
+static int runReplaySelfTest(int seconds) {
+    QTemporaryDir output;
+    ReplayBuffer::Config config;
+    config.keepSeconds = 6;
+    config.segmentSeconds = 1;
+    config.budgetBytes = 8ll * 1024 * 1024;
+    config.fps = 30;
+    config.audioSource.clear();
+
+    ReplayBuffer replay;
+    QString failure;
+    QString savedPath;
+    qint64 savedMs = 0;
+    QObject::connect(&replay, &ReplayBuffer::failed, [&failure](const QString &message) { failure = message; });
+    QObject::connect(&replay, &ReplayBuffer::saved, [&savedPath, &savedMs](const QString &path, qint64 durationMs) {
+        savedPath = path;
+        savedMs = durationMs;
+    });
+    if (!output.isValid() || !replay.start({"-re", "-f", "lavfi", "-i", "testsrc=size=1280x720:rate=30"}, config, output.path())) {
+        qDebug() << "Replay self-test: cannot start ffmpeg" << failure;
+        return 1;
+    }
+
+    pid_t pid = replay.encoderPid();
+    auto rssKb = [pid]() -> qint64 {
+        QFile file(QString("/proc/%1/status").arg(pid));
+        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            for (const QByteArray &line : file.readAll().split('\n')) {
+                if (line.startsWith("VmRSS:")) return line.mid(6).trimmed().split(' ').value(0).toLongLong();
+            }
+        }
+        return 0;
+    };
+    auto cpuTicks = [pid]() -> qint64 {
+        QFile file(QString("/proc/%1/stat").arg(pid));
+        if (!file.open(QIODevice::ReadOnly)) return 0;
+        QByteArray content = file.readAll();
+        QList<QByteArray> fields = content.mid(content.lastIndexOf(')') + 2).split(' ');
+        return fields.size() > 12 ? fields[11].toLongLong() + fields[12].toLongLong() : 0;
+    };
+    auto ringDiskBytes = []() {
+        qint64 total = 0;
+        for (const QFileInfo &info : QDir(ReplayBuffer::ringLocation()).entryInfoList(QDir::Files)) total += info.size();
+        return total;
+    };
+
+    // Measured from the point the ring is full; each half of the remaining run is compared with the other
+    int warmup = config.keepSeconds + 2;
+    seconds = qMax(seconds, warmup + 10);
+    int half = warmup + (seconds - warmup) / 2;
+    qint64 maxRingBytes = 0, maxDiskBytes = 0, rssAtWarmup = 0, rssPeak = 0, ticksAtWarmup = 0, ticksAtHalf = 0;
+    for (int second = 1; second <= seconds && failure.isEmpty(); ++second) {
+        QElapsedTimer tick;
+        tick.start();
+        while (tick.elapsed() < 1000) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+            QThread::msleep(10);
+        }
+        maxRingBytes = qMax(maxRingBytes, replay.ringBytes());
+        maxDiskBytes = qMax(maxDiskBytes, ringDiskBytes());
+        if (second == warmup) {
+            rssAtWarmup = rssKb();
+            ticksAtWarmup = cpuTicks();
+        } else if (second > warmup) {
+            rssPeak = qMax(rssPeak, rssKb());
+        }
+        if (second == half) ticksAtHalf = cpuTicks();
+    }
+    qint64 ticksAtEnd = cpuTicks();
+    qint64 retainedMs = replay.retainedMs();
+
+    replay.save();
+    QElapsedTimer saving;
+    saving.start();
+    while (savedPath.isEmpty() && failure.isEmpty() && saving.elapsed() < 15000) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+        QThread::msleep(10);
+    }
+    replay.stop();
+
+    double firstHalf = double(ticksAtHalf - ticksAtWarmup) / (half - warmup);
+    double secondHalf = double(ticksAtEnd - ticksAtHalf) / (seconds - half);
+    bool boundedRing = maxRingBytes <= config.budgetBytes && maxDiskBytes <= config.budgetBytes * 5 / 4;
+    bool flatMemory = rssPeak <= rssAtWarmup * 5 / 4 + 4096;
+    bool flatCpu = secondHalf <= firstHalf * 1.3 + 5;
+    bool savedWindow = QFileInfo(savedPath).size() > 0 && savedMs >= (config.keepSeconds - config.segmentSeconds) * 1000ll;
+    bool passed = failure.isEmpty() && boundedRing && flatMemory && flatCpu && savedWindow;
+    qDebug() << "Replay self-test" << (passed ? "passed" : "FAILED") << "over" << seconds << "s:"
+             << "ring max" << maxRingBytes / 1024 << "KiB (on tmpfs" << maxDiskBytes / 1024 << "KiB, budget" << config.budgetBytes / 1024 << "KiB),"
+             << "encoder RSS" << rssAtWarmup << "->" << rssPeak << "KiB, CPU ticks/s" << firstHalf << "->" << secondHalf << ","
+             << "retained" << retainedMs << "ms, saved" << savedMs << "ms" << failure;
+    return passed ? 0 : 1;
+}
+
+// Optional argument: run length in seconds (default 30)
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    return runReplaySelfTest(app.arguments().value(1, "30").toInt());
+}
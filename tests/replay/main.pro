@@ -0,0 +1,15 @@
+# Project Configuration
+TEMPLATE = app
+CONFIG += c++23 console
+CONFIG -= app_bundle
+
+# Target Application Name
+TARGET = replay-selftest
+
+# Source Files
+SOURCES += main.cpp
+HEADERS += ../../replaybuffer.h
+
+# Qt Modules
+QT += core
+QT -= gui
@@ -0,0 +1,80 @@
+#include <QCoreApplication>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QFile>
+#include <QDebug>
+#include "../../pulsevolume.h"
+#include <functional>
+
+// Drives PulseVolume against a private headless pulseaudio with a null sink; the session's audio is untouched
+static int runVolumeSelfTest() {
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        return 1;
+    }
+    QString socket = dir.path() + "/native";
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("XDG_RUNTIME_DIR", dir.path());
+    environment.insert("HOME", dir.path());
+    QProcess daemon;
+    daemon.setProcessEnvironment(environment);
+    daemon.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    daemon.start("pulseaudio", {"--system=false", "--daemonize=no", "-n", "--exit-idle-time=-1", "--disable-shm=yes",
+                                "--load=module-null-sink sink_name=apex_selftest",
+                                "--load=module-native-protocol-unix auth-anonymous=1 socket=" + socket});
+    if (!daemon.waitForStarted(3000)) {
+        qDebug() << "Volume self-test: pulseaudio is not installed";
+        return 1;
+    }
+
+    auto waitFor = [](const std::function<bool()> &condition, int timeoutMs) {
+        QElapsedTimer timer;
+        timer.start();
+        while (!condition() && timer.elapsed() < timeoutMs) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+            QThread::msleep(2);
+        }
+        return condition();
+    };
+    bool passed = waitFor([&socket]() { return QFile::exists(socket); }, 5000);
+
+    int reported = -1;
+    PulseVolume volume("unix:" + socket);
+    QObject::connect(&volume, &PulseVolume::volumeChanged, [&reported](int percent, bool) { reported = percent; });
+    passed = passed && waitFor([&reported]() { return reported >= 0; }, 3000);
+
+    // A drag: 200 slider ticks 2 ms apart, ending on 37
+    QElapsedTimer drag;
+    drag.start();
+    for (int tick = 0; passed && tick < 200; ++tick) {
+        volume.setVolume(tick == 199 ? 37 : tick % 100);
+        QCoreApplication::processEvents(QEventLoop::AllEvents);
+        QThread::msleep(2);
+    }
+    qint64 dragMs = drag.elapsed();
+    passed = passed && waitFor([&reported]() { return reported == 37; }, 2000);
+    PulseVolume::Stats stats = volume.statistics();
+    bool coalesced = stats.writes <= dragMs / 16 + 2;
+
+    // A change made by another client must reach us through the subscription
+    int external = QProcess::execute("pactl", {"--server", "unix:" + socket, "set-sink-volume", "apex_selftest", "55%"});
+    bool followed = external == 0 && waitFor([&reported]() { return reported == 55; }, 2000);
+
+    daemon.terminate();
+    if (!daemon.waitForFinished(3000)) {
+        daemon.kill();
+        daemon.waitForFinished();
+    }
+
+    passed = passed && coalesced && followed;
+    qDebug() << "Volume self-test" << (passed ? "passed" : "FAILED") << "requests" << stats.requests << "writes" << stats.writes
+             << "over" << dragMs << "ms, final" << reported;
+    return passed ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    return runVolumeSelfTest();
+}
@@ -0,0 +1,18 @@
+# Project Configuration
+TEMPLATE = app
+CONFIG += c++23 console link_pkgconfig
+CONFIG -= app_bundle
+
+# Target Application Name
+TARGET = volume-selftest
+
+# Source Files
+SOURCES += main.cpp
+HEADERS += ../../pulsevolume.h
+
+# Qt Modules
+QT += core
+QT -= gui
+
+# System Libraries
+PKGCONFIG += libpulse